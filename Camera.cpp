@@ -2,6 +2,15 @@
 #include <iostream>
 #include <cmath>
 #include <chrono> // For time-based rotation
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <filesystem>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <random>
 
 // Include glad
 #include <glad/glad.h>
@@ -9,37 +18,99 @@
 // Include GLFW
 #include <GLFW/glfw3.h>
 
+// Include input recording and replay
+#include "InputRecorder.h"
+
+// Include clustered light binning
+#include "LightClustering.h"
+
+// Include compressed vertex formats
+#include "VertexFormats.h"
+
 // Shader sources
 const char* vertexShaderSource = R"glsl(
 #version 330 core
 layout(location = 0) in vec3 aPos;
 uniform mat4 uMVP;
+uniform mat4 uModelView;
+out vec3 vViewPos;
 void main()
 {
+    vViewPos = (uModelView * vec4(aPos, 1.0)).xyz;
     gl_Position = uMVP * vec4(aPos, 1.0);
 }
 )glsl";
 
+/*
+ * Clustered forward shading:
+ * The fragment finds its froxel from its window position and view depth, then only loops over the
+ * lights binned into that froxel on the CPU. Slices are exponential in depth, matching ClusterGrid.
+ */
 const char* fragmentShaderSource = R"glsl(
 #version 330 core
 uniform vec3 uColor;
+uniform bool uLit;
+uniform samplerBuffer uLightData;      // Two texels per light: view position + radius, color
+uniform usamplerBuffer uClusterRanges; // Offset and count into uLightIndices, one texel per cluster
+uniform usamplerBuffer uLightIndices;
+uniform ivec3 uClusterDims;
+uniform vec2 uViewportSize;
+uniform vec2 uDepthRange;              // Near and far plane distances
+in vec3 vViewPos;
 out vec4 FragColor;
 void main()
 {
-    FragColor = vec4(uColor, 1.0);
+    if (!uLit)
+    {
+        FragColor = vec4(uColor, 1.0);
+        return;
+    }
+
+    // Flat normal from screen-space derivatives, flipped to face the camera
+    vec3 normal = normalize(cross(dFdx(vViewPos), dFdy(vViewPos)));
+    if (dot(normal, vViewPos) > 0.0)
+        normal = -normal;
+
+    ivec3 cell;
+    cell.xy = clamp(ivec2(gl_FragCoord.xy / uViewportSize * vec2(uClusterDims.xy)), ivec2(0), uClusterDims.xy - 1);
+    float depth = -vViewPos.z;
+    cell.z = clamp(int(log(depth / uDepthRange.x) / log(uDepthRange.y / uDepthRange.x) * float(uClusterDims.z)), 0, uClusterDims.z - 1);
+    int cluster = (cell.z * uClusterDims.y + cell.y) * uClusterDims.x + cell.x;
+    uvec2 range = texelFetch(uClusterRanges, cluster).xy;
+
+    vec3 lighting = vec3(0.05); // Ambient term
+    for (uint i = 0u; i < range.y; ++i)
+    {
+        int light = int(texelFetch(uLightIndices, int(range.x + i)).r);
+        vec4 positionRadius = texelFetch(uLightData, 2 * light);
+        vec3 color = texelFetch(uLightData, 2 * light + 1).rgb;
+
+        // Smooth window falloff reaching zero exactly at the light radius
+        vec3 toLight = positionRadius.xyz - vViewPos;
+        float dist2 = dot(toLight, toLight);
+        float falloff = clamp(1.0 - dist2 / (positionRadius.w * positionRadius.w), 0.0, 1.0);
+        falloff *= falloff;
+        lighting += color * falloff * max(dot(normal, toLight * inversesqrt(dist2)), 0.0);
+    }
+    FragColor = vec4(uColor * lighting, 1.0);
 }
 )glsl";
 
 // Global variables
 GLFWwindow* window;
-int width = 800, height = 600;
+int width = 800, height = 600; // Size the current frame renders at, taken from its FrameInput
+int framebufferWidth = 800, framebufferHeight = 600; // Live framebuffer size reported by GLFW
 
 // Camera parameters
 float angleX = 0.0f, angleY = 0.0f, distance = 5.0f;
 
+// Projection parameters, shared by the projection matrix and the light cluster grid
+const float cameraFovY = 45.0f, cameraNear = 0.1f, cameraFar = 100.0f;
+
 // Timing variables for automatic rotation
 float deltaTime = 0.0f; // Time between current frame and last frame
 float lastFrame = 0.0f;
+double elapsedTime = 0.0; // Sum of all frame deltas; drives animation instead of the wall clock
 
 // Define a 3D vector class
 class Vector3 {
@@ -143,6 +214,16 @@ public:
         return result;
     }
 
+    // Scale matrix
+    static Matrix4 scale(const Vector3& v) {
+        Matrix4 result;
+        // Place the scale factors on the diagonal
+        result.m[0] = v.x;
+        result.m[5] = v.y;
+        result.m[10] = v.z;
+        return result;
+    }
+
     /*
      * Rotation matrix around an arbitrary axis using Rodrigues' rotation formula.
      *
@@ -226,16 +307,41 @@ public:
     }
 };
 
+// Point light in world space
+struct PointLight {
+    Vector3 position;
+    float radius;
+    Vector3 color;
+};
+
+// Scene lights and the froxel grid they are binned into every frame
+std::vector<PointLight> sceneLights;
+ClusterGrid clusterGrid;
+ClusterLightBinner lightBinner;
+
 // Function prototypes
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void processInput(GLFWwindow* window);
+FrameInput pollInput(GLFWwindow* window, float frameDelta);
+void resizeWindowToFramebuffer(GLFWwindow* window, int w, int h);
+void processInput(GLFWwindow* window, const FrameInput& input);
 unsigned int createShaderProgram();
-void drawAxes(unsigned int shaderProgram);
+Matrix4 cameraViewMatrix();
+Matrix4 cameraProjectionMatrix();
+void createSceneLights(int count);
+void binSceneLights(unsigned int shaderProgram, const Matrix4& view);
+Matrix4 packedMeshModelMatrix(const PackedMesh& mesh);
+void setupPackedMeshAttributes(const PackedMesh& mesh);
+void drawGround(unsigned int shaderProgram, const Matrix4& view, const Matrix4& projection);
+void drawAxes(unsigned int shaderProgram, const Matrix4& view, const Matrix4& projection);
 void updateCameraAngles();
+int runLightBinningBenchmark();
+int runVertexFormatReport();
+bool parseLightCount(const char* text, int& count);
 
 /*
  * framebuffer_size_callback:
- * Adjusts the OpenGL viewport when the window size changes.
+ * Remembers the new framebuffer size when the window size changes. The viewport is adjusted by
+ * processInput once the size reaches a frame's input, so replays can use the recorded size instead.
  *
  * Parameters:
  * - window: The GLFW window that was resized.
@@ -244,35 +350,100 @@ void updateCameraAngles();
  */
 void framebuffer_size_callback(GLFWwindow* window, int w, int h)
 {
-    width = w;
-    height = h;
-    glViewport(0, 0, width, height);
+    framebufferWidth = w;
+    framebufferHeight = h;
 }
 
 /*
- * processInput:
- * Handles user input for zooming the camera in and out.
+ * resizeWindowToFramebuffer:
+ * Resizes the window so that its framebuffer gets the given size in pixels.
+ *
+ * Replays use this to render at the recorded framebuffer size, so the viewport never extends past the
+ * default framebuffer. Window sizes are in screen coordinates, which differ from framebuffer pixels on
+ * HiDPI displays, so the request is scaled by the current window-to-framebuffer ratio.
+ *
+ * Parameters:
+ * - window: The GLFW window to resize.
+ * - w: The framebuffer width to reach.
+ * - h: The framebuffer height to reach.
+ */
+void resizeWindowToFramebuffer(GLFWwindow* window, int w, int h)
+{
+    // Skip minimized frames and repeated requests while an earlier resize is still being applied
+    static int requestedWidth = 0, requestedHeight = 0;
+    if (w <= 0 || h <= 0 || (w == requestedWidth && h == requestedHeight))
+        return;
+    requestedWidth = w;
+    requestedHeight = h;
+
+    int windowWidth, windowHeight;
+    glfwGetWindowSize(window, &windowWidth, &windowHeight);
+    float scaleX = framebufferWidth > 0 ? (float)windowWidth / (float)framebufferWidth : 1.0f;
+    float scaleY = framebufferHeight > 0 ? (float)windowHeight / (float)framebufferHeight : 1.0f;
+    glfwSetWindowSize(window, (int)lrintf(w * scaleX), (int)lrintf(h * scaleY));
+}
+
+/*
+ * pollInput:
+ * Captures the live keyboard state for the current frame.
  *
  * Parameters:
  * - window: The GLFW window to poll input from.
+ * - frameDelta: Wall-clock time elapsed since the previous frame.
+ *
+ * Returns:
+ * - A FrameInput holding the frame delta, the pressed keys and the framebuffer size, ready to be applied or recorded.
+ */
+FrameInput pollInput(GLFWwindow* window, float frameDelta)
+{
+    FrameInput input;
+    input.deltaTime = frameDelta;
+    input.framebufferWidth = (uint16_t)framebufferWidth;
+    input.framebufferHeight = (uint16_t)framebufferHeight;
+
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+        input.keys |= FrameInput::KeyEscape;
+    if (glfwGetKey(window, GLFW_KEY_EQUAL) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_KP_ADD) == GLFW_PRESS)
+        input.keys |= FrameInput::KeyZoomIn;
+    if (glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_KP_SUBTRACT) == GLFW_PRESS)
+        input.keys |= FrameInput::KeyZoomOut;
+
+    return input;
+}
+
+/*
+ * processInput:
+ * Handles user input for zooming the camera in and out, and applies the frame's framebuffer size to the viewport.
+ *
+ * Parameters:
+ * - window: The GLFW window to close when ESC is pressed.
+ * - input: The frame's input, either polled live or read back from a recording.
  */
-void processInput(GLFWwindow* window)
+void processInput(GLFWwindow* window, const FrameInput& input)
 {
     const float distanceStep = 0.1f;
 
+    // Adjust the OpenGL viewport when the framebuffer size changes
+    if (input.framebufferWidth != width || input.framebufferHeight != height)
+    {
+        width = input.framebufferWidth;
+        height = input.framebufferHeight;
+        glViewport(0, 0, width, height);
+    }
+
     // Close the window if the ESC key is pressed
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+    if (input.isDown(FrameInput::KeyEscape))
         glfwSetWindowShouldClose(window, true);
 
     // Zoom in: Decrease the distance from the camera to the target
-    if (glfwGetKey(window, GLFW_KEY_EQUAL) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_KP_ADD) == GLFW_PRESS)
+    if (input.isDown(FrameInput::KeyZoomIn))
     {
         distance -= distanceStep;
         if (distance < 1.0f) distance = 1.0f; // Prevent the camera from getting too close
     }
 
     // Zoom out: Increase the distance from the camera to the target
-    if (glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_KP_SUBTRACT) == GLFW_PRESS)
+    if (input.isDown(FrameInput::KeyZoomOut))
     {
         distance += distanceStep;
     }
@@ -285,6 +456,8 @@ void processInput(GLFWwindow* window)
  * Mathematical Concept:
  * - The camera's horizontal angle (angleX) increases linearly over time to create a continuous rotation around the Y-axis.
  * - The vertical angle (angleY) oscillates sinusoidally to make the camera move up and down smoothly.
+ * - Both are driven by the accumulated frame deltas rather than glfwGetTime(), so a replayed run
+ *   reproduces the same angles regardless of how fast it renders.
  *
  * Parameters:
  * - None
@@ -298,7 +471,7 @@ void updateCameraAngles()
     if (angleX >= 360.0f) angleX -= 360.0f;
 
     // Oscillate angleY between -15 and +15 degrees using a sine wave
-    angleY = 15.0f * sinf(glfwGetTime());
+    angleY = 15.0f * sinf((float)elapsedTime);
 }
 
 /*
@@ -365,54 +538,14 @@ unsigned int createShaderProgram()
 }
 
 /*
- * drawAxes:
- * Renders the X, Y, and Z axes centered at the origin.
- *
- * Mathematical Concepts:
- * - Model-View-Projection (MVP) Matrix: Transforms vertex positions from model space to clip space.
- * - Line Primitives: Used to draw the axes as lines in 3D space.
+ * cameraViewMatrix:
+ * Builds the view matrix of the camera orbiting the origin.
  *
- * Parameters:
- * - shaderProgram: The ID of the shader program to use for rendering.
+ * Returns:
+ * - The matrix transforming world coordinates into camera (view) coordinates.
  */
-void drawAxes(unsigned int shaderProgram)
+Matrix4 cameraViewMatrix()
 {
-    // Define axis vertices: each axis is represented by two points (origin to positive direction)
-    float axisVertices[] = {
-        // Positions
-         0.0f, 0.0f, 0.0f,  // Origin
-         1.0f, 0.0f, 0.0f,  // X-axis
-         0.0f, 0.0f, 0.0f,  // Origin
-         0.0f, 1.0f, 0.0f,  // Y-axis
-         0.0f, 0.0f, 0.0f,  // Origin
-         0.0f, 0.0f, 1.0f   // Z-axis
-    };
-
-    // Static VAO and VBO to ensure they are created only once
-    static unsigned int VAO = 0, VBO = 0;
-    if (VAO == 0)
-    {
-        // Generate Vertex Array Object and Vertex Buffer Object
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-
-        // Bind VAO to store vertex attribute configuration
-        glBindVertexArray(VAO);
-
-        // Bind and buffer vertex data
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(axisVertices), axisVertices, GL_STATIC_DRAW);
-
-        // Define vertex attribute pointers
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
-    }
-
-    // Calculate view and projection matrices manually
-
-    // Model matrix (identity) since axes are centered at the origin
-    Matrix4 model;
-
     /*
      * Camera Position Calculation:
      *
@@ -478,6 +611,18 @@ void drawAxes(unsigned int shaderProgram)
     Matrix4 translation = Matrix4::translation(-position);
     view = view * translation; // Combine rotation and translation
 
+    return view;
+}
+
+/*
+ * cameraProjectionMatrix:
+ * Builds the perspective projection for the current window size.
+ *
+ * Returns:
+ * - The matrix transforming camera (view) coordinates into clip space.
+ */
+Matrix4 cameraProjectionMatrix()
+{
     /*
      * Projection Matrix:
      *
@@ -485,7 +630,316 @@ void drawAxes(unsigned int shaderProgram)
      * It simulates the effect of perspective, where objects farther away appear smaller.
      */
     float aspectRatio = (float)width / (float)height;
-    Matrix4 projection = Matrix4::perspective(45.0f, aspectRatio, 0.1f, 100.0f);
+    return Matrix4::perspective(cameraFovY, aspectRatio, cameraNear, cameraFar);
+}
+
+/*
+ * createSceneLights:
+ * Scatters point lights with random colors just above the ground plane.
+ *
+ * A fixed seed keeps the light layout identical between runs, so recorded input replays render the same scene.
+ *
+ * Parameters:
+ * - count: The number of lights to create.
+ */
+void createSceneLights(int count)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> spread(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> height(0.05f, 0.5f);
+    std::uniform_real_distribution<float> radius(0.3f, 1.5f);
+    std::uniform_real_distribution<float> channel(0.2f, 1.0f);
+
+    sceneLights.resize(count);
+    for (PointLight& light : sceneLights)
+    {
+        light.position = Vector3(spread(rng), height(rng), spread(rng));
+        light.radius = radius(rng);
+        light.color = Vector3(channel(rng), channel(rng), channel(rng));
+    }
+}
+
+/*
+ * binSceneLights:
+ * Moves the scene lights into view space, bins them into the froxel grid and uploads the result.
+ *
+ * GPU Layout (texture buffers, since OpenGL 3.3 has no storage buffers):
+ * - uLightData: RGBA32F, two texels per light (view position + radius, color).
+ * - uClusterRanges: RG32UI, one (offset, count) texel per cluster.
+ * - uLightIndices: R32UI, the light lists of all clusters in a single buffer.
+ *
+ * Each buffer must fit in GL_MAX_TEXTURE_BUFFER_SIZE texels, which OpenGL 3.3 only guarantees to be 65536.
+ * Lights past half that limit are left out, and when the index list outgrows it the clusters keep only the
+ * indices that fit. Both cases are reported once.
+ *
+ * Parameters:
+ * - shaderProgram: The ID of the shader program whose samplers and cluster uniforms are set.
+ * - view: The camera's view matrix.
+ */
+void binSceneLights(unsigned int shaderProgram, const Matrix4& view)
+{
+    // Texture buffer size limit, queried once
+    static GLint maxBufferTexels = 0;
+    if (maxBufferTexels == 0)
+        glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxBufferTexels);
+
+    // View-space light positions as structure-of-arrays for the binner, plus the interleaved GPU copy
+    static std::vector<float> lightX, lightY, lightZ, lightRadius, lightData;
+    size_t count = sceneLights.size();
+    size_t maxLights = (size_t)maxBufferTexels / 2;
+    if (count > maxLights)
+    {
+        static bool warned = false;
+        if (!warned)
+            std::cerr << "Light data exceeds GL_MAX_TEXTURE_BUFFER_SIZE (" << maxBufferTexels << " texels): shading only "
+                      << maxLights << " of " << count << " lights" << std::endl;
+        warned = true;
+        count = maxLights;
+    }
+    lightX.resize(count);
+    lightY.resize(count);
+    lightZ.resize(count);
+    lightRadius.resize(count);
+    lightData.resize(8 * (count > 0 ? count : 1));
+
+    const float* m = view.m;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const PointLight& light = sceneLights[i];
+        const Vector3& p = light.position;
+        lightX[i] = m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12];
+        lightY[i] = m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13];
+        lightZ[i] = m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14];
+        lightRadius[i] = light.radius;
+
+        float* texel = &lightData[8 * i];
+        texel[0] = lightX[i];
+        texel[1] = lightY[i];
+        texel[2] = lightZ[i];
+        texel[3] = light.radius;
+        texel[4] = light.color.x;
+        texel[5] = light.color.y;
+        texel[6] = light.color.z;
+        texel[7] = 0.0f;
+    }
+
+    // Keep the grid in sync with the projection (the aspect ratio changes when the window is resized)
+    clusterGrid.setPerspective(cameraFovY, (float)width / (float)height, cameraNear, cameraFar);
+    lightBinner.bin(clusterGrid, lightX.data(), lightY.data(), lightZ.data(), lightRadius.data(), (int)count);
+
+    const std::vector<uint32_t>* ranges = &lightBinner.clusterRanges();
+    const std::vector<uint32_t>& indices = lightBinner.lightIndices();
+    size_t indexCount = indices.size();
+    static const uint32_t emptyIndex = 0; // Texture buffers need storage even when no cluster has a light
+
+    // Cut every cluster's light list at the end of the largest index buffer the GPU can sample
+    if (indexCount > (size_t)maxBufferTexels)
+    {
+        static bool warned = false;
+        if (!warned)
+            std::cerr << "Cluster light indices exceed GL_MAX_TEXTURE_BUFFER_SIZE (" << maxBufferTexels << " texels): "
+                      << indexCount << " indices this frame, dropping lights from the last clusters" << std::endl;
+        warned = true;
+
+        static std::vector<uint32_t> clampedRanges;
+        clampedRanges = *ranges;
+        indexCount = (size_t)maxBufferTexels;
+        for (size_t i = 0; i < clampedRanges.size(); i += 2)
+        {
+            uint32_t available = clampedRanges[i] < indexCount ? (uint32_t)indexCount - clampedRanges[i] : 0;
+            clampedRanges[i + 1] = std::min(clampedRanges[i + 1], available);
+        }
+        ranges = &clampedRanges;
+    }
+
+    // Static buffers and textures to ensure they are created only once
+    static unsigned int buffers[3] = { 0, 0, 0 }, textures[3] = { 0, 0, 0 };
+    if (buffers[0] == 0)
+    {
+        glGenBuffers(3, buffers);
+        glGenTextures(3, textures);
+    }
+
+    // Re-specify each buffer's storage every frame so the driver can hand out fresh memory instead of stalling
+    glBindBuffer(GL_TEXTURE_BUFFER, buffers[0]);
+    glBufferData(GL_TEXTURE_BUFFER, lightData.size() * sizeof(float), lightData.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffers[1]);
+    glBufferData(GL_TEXTURE_BUFFER, ranges->size() * sizeof(uint32_t), ranges->data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffers[2]);
+    if (indexCount == 0)
+        glBufferData(GL_TEXTURE_BUFFER, sizeof(emptyIndex), &emptyIndex, GL_STREAM_DRAW);
+    else
+        glBufferData(GL_TEXTURE_BUFFER, indexCount * sizeof(uint32_t), indices.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    // Attach the buffers to texture units 0-2
+    const GLenum formats[3] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+    const GLenum units[3] = { GL_TEXTURE0, GL_TEXTURE1, GL_TEXTURE2 };
+    for (int i = 0; i < 3; ++i)
+    {
+        glActiveTexture(units[i]);
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+        glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffers[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    glUseProgram(shaderProgram);
+    glUniform1i(glGetUniformLocation(shaderProgram, "uLightData"), 0);
+    glUniform1i(glGetUniformLocation(shaderProgram, "uClusterRanges"), 1);
+    glUniform1i(glGetUniformLocation(shaderProgram, "uLightIndices"), 2);
+    glUniform3i(glGetUniformLocation(shaderProgram, "uClusterDims"), clusterGrid.tilesX, clusterGrid.tilesY, clusterGrid.slicesZ);
+    glUniform2f(glGetUniformLocation(shaderProgram, "uViewportSize"), (float)width, (float)height);
+    glUniform2f(glGetUniformLocation(shaderProgram, "uDepthRange"), clusterGrid.zNear, clusterGrid.zFar);
+}
+
+/*
+ * packedMeshModelMatrix:
+ * Returns the matrix that maps a packed mesh's stored positions back to model space.
+ *
+ * Mathematical Concept:
+ * - Quantized positions reach the shader as normalized [0, 1] values, so model-space positions are
+ *   p = boundsMin + q * (boundsMax - boundsMin): a scale by the bounds' extent followed by a translation
+ *   to their minimum. Folding this into the model matrix leaves the vertex shader unchanged.
+ * - Float positions are already in model space and get the identity.
+ *
+ * Parameters:
+ * - mesh: The packed mesh being drawn.
+ */
+Matrix4 packedMeshModelMatrix(const PackedMesh& mesh)
+{
+    if (mesh.layout.position != VertexLayout::PositionUnorm16)
+        return Matrix4();
+
+    const MeshBounds& b = mesh.bounds;
+    return Matrix4::translation(Vector3(b.min[0], b.min[1], b.min[2])) *
+           Matrix4::scale(Vector3(b.extent(0), b.extent(1), b.extent(2)));
+}
+
+/*
+ * setupPackedMeshAttributes:
+ * Uploads a packed mesh into the bound VAO's vertex buffer and describes its position attribute (location 0).
+ *
+ * The shaders only consume positions, so the mesh must not carry normal or UV streams: they would be uploaded
+ * but never bound. Their packed formats are used on the CPU side only for now (see --vertex-report).
+ *
+ * Parameters:
+ * - mesh: The packed mesh to upload.
+ */
+void setupPackedMeshAttributes(const PackedMesh& mesh)
+{
+    assert(mesh.layout.normal == VertexLayout::NormalNone && mesh.layout.uv == VertexLayout::UvNone);
+    glBufferData(GL_ARRAY_BUFFER, mesh.data.size(), mesh.data.data(), GL_STATIC_DRAW);
+
+    if (mesh.layout.position == VertexLayout::PositionUnorm16)
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, (GLsizei)mesh.position.stride, (void*)mesh.position.offset);
+    else
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (GLsizei)mesh.position.stride, (void*)mesh.position.offset);
+    glEnableVertexAttribArray(0);
+}
+
+/*
+ * drawGround:
+ * Renders a lit ground plane at y = 0 for the point lights to illuminate.
+ *
+ * Parameters:
+ * - shaderProgram: The ID of the shader program to use for rendering.
+ * - view: The camera's view matrix.
+ * - projection: The camera's projection matrix.
+ */
+void drawGround(unsigned int shaderProgram, const Matrix4& view, const Matrix4& projection)
+{
+    // Two triangles covering the area the lights are scattered over
+    float groundVertices[] = {
+        -10.0f, 0.0f, -10.0f,
+         10.0f, 0.0f, -10.0f,
+         10.0f, 0.0f,  10.0f,
+        -10.0f, 0.0f, -10.0f,
+         10.0f, 0.0f,  10.0f,
+        -10.0f, 0.0f,  10.0f
+    };
+
+    // Static VAO, VBO and packed vertices to ensure they are created only once
+    static unsigned int VAO = 0, VBO = 0;
+    static PackedMesh mesh;
+    if (VAO == 0)
+    {
+        VertexLayout layout;
+        layout.position = VertexLayout::PositionUnorm16;
+        mesh = packMesh(layout, groundVertices, nullptr, nullptr, 6);
+
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        setupPackedMeshAttributes(mesh);
+    }
+
+    // The ground sits at the origin, so the model matrix only undoes the position quantization
+    Matrix4 model = packedMeshModelMatrix(mesh);
+    Matrix4 modelView = view * model;
+    Matrix4 mvp = projection * view * model;
+
+    glUseProgram(shaderProgram);
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "uMVP"), 1, GL_FALSE, mvp.m);
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "uModelView"), 1, GL_FALSE, modelView.m);
+    glUniform1i(glGetUniformLocation(shaderProgram, "uLit"), 1);
+    glUniform3f(glGetUniformLocation(shaderProgram, "uColor"), 0.8f, 0.8f, 0.8f);
+
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+}
+
+/*
+ * drawAxes:
+ * Renders the X, Y, and Z axes centered at the origin.
+ *
+ * Mathematical Concepts:
+ * - Model-View-Projection (MVP) Matrix: Transforms vertex positions from model space to clip space.
+ * - Line Primitives: Used to draw the axes as lines in 3D space.
+ *
+ * Parameters:
+ * - shaderProgram: The ID of the shader program to use for rendering.
+ * - view: The camera's view matrix.
+ * - projection: The camera's projection matrix.
+ */
+void drawAxes(unsigned int shaderProgram, const Matrix4& view, const Matrix4& projection)
+{
+    // Define axis vertices: each axis is represented by two points (origin to positive direction)
+    float axisVertices[] = {
+        // Positions
+         0.0f, 0.0f, 0.0f,  // Origin
+         1.0f, 0.0f, 0.0f,  // X-axis
+         0.0f, 0.0f, 0.0f,  // Origin
+         0.0f, 1.0f, 0.0f,  // Y-axis
+         0.0f, 0.0f, 0.0f,  // Origin
+         0.0f, 0.0f, 1.0f   // Z-axis
+    };
+
+    // Static VAO, VBO and packed vertices to ensure they are created only once
+    static unsigned int VAO = 0, VBO = 0;
+    static PackedMesh mesh;
+    if (VAO == 0)
+    {
+        // Quantize the positions to 16 bits per component within the axes' bounds
+        VertexLayout layout;
+        layout.position = VertexLayout::PositionUnorm16;
+        mesh = packMesh(layout, axisVertices, nullptr, nullptr, 6);
+
+        // Generate Vertex Array Object and Vertex Buffer Object
+        glGenVertexArrays(1, &VAO);
+        glGenBuffers(1, &VBO);
+
+        // Bind VAO to store vertex attribute configuration
+        glBindVertexArray(VAO);
+
+        // Bind, buffer vertex data and define vertex attribute pointers
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        setupPackedMeshAttributes(mesh);
+    }
+
+    // Axes are centered at the origin, so the model matrix only undoes the position quantization
+    Matrix4 model = packedMeshModelMatrix(mesh);
 
     /*
      * Model-View-Projection (MVP) Matrix:
@@ -501,6 +955,11 @@ void drawAxes(unsigned int shaderProgram)
     // Set the MVP matrix uniform in the vertex shader
     int mvpLoc = glGetUniformLocation(shaderProgram, "uMVP");
     glUniformMatrix4fv(mvpLoc, 1, GL_FALSE, mvp.m);
+    Matrix4 modelView = view * model;
+    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "uModelView"), 1, GL_FALSE, modelView.m);
+
+    // Axes are drawn in flat colors, without lighting
+    glUniform1i(glGetUniformLocation(shaderProgram, "uLit"), 0);
 
     // Bind the VAO containing the axis vertices
     glBindVertexArray(VAO);
@@ -521,13 +980,252 @@ void drawAxes(unsigned int shaderProgram)
     glBindVertexArray(0);
 }
 
+/*
+ * runLightBinningBenchmark:
+ * Measures CPU light binning time against light count, single-threaded and with all hardware threads.
+ *
+ * Lights are placed at random inside the view frustum of the default camera. No window or OpenGL
+ * context is needed.
+ *
+ * Returns:
+ * - The process exit code.
+ */
+int runLightBinningBenchmark()
+{
+    const int lightCounts[] = { 256, 1024, 4096, 16384, 65536 };
+    const int iterations = 20;
+
+    ClusterGrid grid;
+    grid.setPerspective(cameraFovY, (float)width / (float)height, cameraNear, cameraFar);
+
+    ClusterLightBinner singleThreaded;
+    singleThreaded.setThreadCount(1);
+    ClusterLightBinner multiThreaded;
+
+    std::cout << "Clusters: " << grid.tilesX << "x" << grid.tilesY << "x" << grid.slicesZ
+              << ", threads: " << multiThreaded.threads() << ", iterations: " << iterations << std::endl;
+    std::cout << "lights\t1 thread (ms)\t" << multiThreaded.threads() << " threads (ms)\tindices" << std::endl;
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int count : lightCounts)
+    {
+        // Uniform in NDC x/y and in depth up to a quarter of the far plane, with radii of 0.5 to 2 units
+        std::vector<float> x(count), y(count), z(count), radius(count);
+        for (int i = 0; i < count; ++i)
+        {
+            float depth = cameraNear + unit(rng) * (cameraFar * 0.25f - cameraNear);
+            x[i] = (unit(rng) * 2.0f - 1.0f) * grid.tanHalfFovX * depth;
+            y[i] = (unit(rng) * 2.0f - 1.0f) * grid.tanHalfFovY * depth;
+            z[i] = -depth;
+            radius[i] = 0.5f + unit(rng) * 1.5f;
+        }
+
+        double milliseconds[2];
+        ClusterLightBinner* binners[2] = { &singleThreaded, &multiThreaded };
+        for (int b = 0; b < 2; ++b)
+        {
+            // One warm-up run so vectors are already sized for the timed runs
+            binners[b]->bin(grid, x.data(), y.data(), z.data(), radius.data(), count);
+
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i)
+                binners[b]->bin(grid, x.data(), y.data(), z.data(), radius.data(), count);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            milliseconds[b] = elapsed.count() / iterations;
+        }
+
+        std::cout << count << "\t" << milliseconds[0] << "\t\t" << milliseconds[1] << "\t\t"
+                  << multiThreaded.lightIndices().size() << std::endl;
+    }
+
+    return 0;
+}
+
+/*
+ * runVertexFormatReport:
+ * Packs a dense UV sphere into several vertex layouts and prints memory use, measured error and
+ * encode/decode times for each.
+ *
+ * Returns:
+ * - The process exit code.
+ */
+int runVertexFormatReport()
+{
+    // UV sphere of radius 2 centered away from the origin, so the quantization bounds are not symmetric
+    const int rings = 500, segments = 1000;
+    std::vector<float> positions, normals, uvs;
+    for (int r = 0; r <= rings; ++r)
+    {
+        float v = (float)r / rings;
+        float phi = v * 3.14159265f;
+        for (int s = 0; s <= segments; ++s)
+        {
+            float u = (float)s / segments;
+            float theta = u * 2.0f * 3.14159265f;
+            Vector3 n(sinf(phi) * cosf(theta), cosf(phi), sinf(phi) * sinf(theta));
+            Vector3 p = n * 2.0f + Vector3(3.0f, 1.0f, -2.0f);
+            positions.insert(positions.end(), { p.x, p.y, p.z });
+            normals.insert(normals.end(), { n.x, n.y, n.z });
+            uvs.insert(uvs.end(), { u, v });
+        }
+    }
+    size_t count = positions.size() / 3;
+
+    struct NamedLayout {
+        const char* name;
+        VertexLayout layout;
+    };
+    NamedLayout layouts[4];
+    layouts[0].name = "float32 interleaved";
+    layouts[0].layout.normal = VertexLayout::NormalFloat3;
+    layouts[0].layout.uv = VertexLayout::UvFloat2;
+    layouts[1].name = "unorm16 pos only";
+    layouts[1].layout = layouts[0].layout;
+    layouts[1].layout.position = VertexLayout::PositionUnorm16;
+    layouts[2].name = "packed interleaved";
+    layouts[2].layout.position = VertexLayout::PositionUnorm16;
+    layouts[2].layout.normal = VertexLayout::NormalOctahedral16;
+    layouts[2].layout.uv = VertexLayout::UvHalf2;
+    layouts[3].name = "packed streams";
+    layouts[3].layout = layouts[2].layout;
+    layouts[3].layout.streams = VertexLayout::SeparateStreams;
+
+    std::cout << "Mesh: " << count << " vertices (position, normal, UV)" << std::endl;
+    std::cout << "layout\t\t\tbytes\t\treduction\tpos err (bound)\t\tnormal err deg (bound)\t\tuv err (bound)\t\t"
+              << "encode (ms)\tdecode (ms)" << std::endl;
+    for (const NamedLayout& entry : layouts)
+    {
+        auto start = std::chrono::steady_clock::now();
+        PackedMesh mesh = packMesh(entry.layout, positions.data(), normals.data(), uvs.data(), count);
+        std::chrono::duration<double, std::milli> encodeTime = std::chrono::steady_clock::now() - start;
+
+        std::vector<float> decodedPositions, decodedNormals, decodedUvs;
+        start = std::chrono::steady_clock::now();
+        unpackMesh(mesh, decodedPositions, decodedNormals, decodedUvs);
+        std::chrono::duration<double, std::milli> decodeTime = std::chrono::steady_clock::now() - start;
+
+        VertexCompressionReport report = measureCompression(mesh, positions.data(), normals.data(), uvs.data());
+        std::cout << entry.name << "\t" << report.packedBytes << "\t" << report.reduction() * 100.0f << "%\t\t"
+                  << report.maxPositionError << " (" << report.positionErrorBound << ")\t"
+                  << report.maxNormalErrorDegrees << " (" << report.normalErrorBoundDegrees << ")\t"
+                  << report.maxUvError << " (" << report.uvErrorBound << ")\t"
+                  << encodeTime.count() << "\t\t" << decodeTime.count() << std::endl;
+    }
+
+    return 0;
+}
+
+/*
+ * parseLightCount:
+ * Parses a non-negative light count from a command line argument.
+ *
+ * Parameters:
+ * - text: The argument to parse.
+ * - count: Receives the parsed count on success.
+ *
+ * Returns:
+ * - true if the whole argument is a number between 0 and INT_MAX.
+ */
+bool parseLightCount(const char* text, int& count)
+{
+    char* end = nullptr;
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || value < 0 || value > INT_MAX)
+        return false;
+
+    count = (int)value;
+    return true;
+}
+
 /*
  * main:
  * The entry point of the application. Initializes GLFW and glad, sets up the window, compiles shaders,
  * and enters the render loop where it continuously updates the camera and renders the scene.
+ *
+ * Command line options:
+ * - --record <file>: Write every frame's input and time delta to a binary log.
+ * - --replay <file>: Drive the app from a recorded log instead of live input. Vsync is disabled so the
+ *   replay runs as fast as the machine allows, and the app exits when the log is exhausted. The light count is
+ *   taken from the log; an explicit --lights that differs from it is rejected.
+ * - --headless: Keep the window hidden (useful for profiling a replay).
+ * - --lights <count>: Number of point lights scattered over the ground plane (default 1024).
+ * - --bench-lights: Print CPU light binning times for increasing light counts and exit.
+ * - --vertex-report: Print memory use and error of the compressed vertex layouts and exit.
  */
-int main()
+int main(int argc, char** argv)
 {
+    std::string recordPath, replayPath;
+    bool headless = false;
+    int lightCount = 1024;
+    bool lightCountGiven = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (arg == "--replay" && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (arg == "--headless")
+            headless = true;
+        else if (arg == "--lights" && i + 1 < argc && parseLightCount(argv[i + 1], lightCount))
+        {
+            lightCountGiven = true;
+            ++i;
+        }
+        else if (arg == "--bench-lights")
+            return runLightBinningBenchmark();
+        else if (arg == "--vertex-report")
+            return runVertexFormatReport();
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--record <file> | --replay <file>] [--headless] [--lights <count>]"
+                      << " | --bench-lights | --vertex-report" << std::endl;
+            return -1;
+        }
+    }
+
+    // Open the replay log first: opening the recording truncates its file, which must not be the replay log
+    InputReplayer replayer;
+    if (!replayPath.empty() && !replayer.open(replayPath))
+    {
+        std::cerr << "Failed to open input log for replay: " << replayPath << std::endl;
+        return -1;
+    }
+
+    // A replay renders the recorded scene, so its light count comes from the log
+    if (replayer.isOpen())
+    {
+        if (lightCountGiven && (uint32_t)lightCount != replayer.lightCount())
+        {
+            std::cerr << "--lights " << lightCount << " does not match the " << replayer.lightCount()
+                      << " lights recorded in " << replayPath << std::endl;
+            return -1;
+        }
+        if (replayer.lightCount() > (uint32_t)INT_MAX)
+        {
+            std::cerr << "Input log records an invalid light count: " << replayer.lightCount() << std::endl;
+            return -1;
+        }
+        lightCount = (int)replayer.lightCount();
+    }
+
+    std::error_code sameFileError;
+    if (!recordPath.empty() && !replayPath.empty() &&
+        (recordPath == replayPath || std::filesystem::equivalent(recordPath, replayPath, sameFileError)))
+    {
+        std::cerr << "Cannot record to the input log being replayed: " << recordPath << std::endl;
+        return -1;
+    }
+
+    InputRecorder recorder;
+    if (!recordPath.empty() && !recorder.open(recordPath, (uint32_t)lightCount))
+    {
+        std::cerr << "Failed to open input log for recording: " << recordPath << std::endl;
+        return -1;
+    }
+
     // Initialize GLFW
     if (!glfwInit())
     {
@@ -543,6 +1241,8 @@ int main()
 #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
+    if (headless)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
     // Create a GLFWwindow object
     window = glfwCreateWindow(width, height, "Camera Rotation Around Center", NULL, NULL);
@@ -554,9 +1254,18 @@ int main()
     }
     glfwMakeContextCurrent(window);
 
+    // Replays are not paced by the display: render every recorded frame as soon as the previous one is done
+    if (replayer.isOpen())
+        glfwSwapInterval(0);
+
     // Set the framebuffer resize callback to adjust the viewport when the window size changes
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
+    // The framebuffer can be larger than the requested window size (e.g. on HiDPI displays), so start from its actual size
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    width = framebufferWidth;
+    height = framebufferHeight;
+
     // Load OpenGL function pointers using glad
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -567,19 +1276,56 @@ int main()
     // Compile and link shaders into a shader program
     unsigned int shaderProgram = createShaderProgram();
 
+    // Match the viewport to the framebuffer size
+    glViewport(0, 0, width, height);
+
     // Enable depth testing to ensure correct rendering of 3D objects
     glEnable(GL_DEPTH_TEST);
 
+    // Populate the scene with point lights for clustered shading
+    createSceneLights(lightCount);
+
+    // Size the window for the first recorded frame before rendering anything
+    FrameInput firstFrame;
+    if (replayer.isOpen() && replayer.peek(firstFrame))
+    {
+        resizeWindowToFramebuffer(window, firstFrame.framebufferWidth, firstFrame.framebufferHeight);
+        glfwPollEvents();
+    }
+
+    // Wall-clock start of the render loop, used to report replay throughput
+    double loopStart = glfwGetTime();
+    lastFrame = (float)loopStart;
+
     // Render loop: runs until the window should close
     while (!glfwWindowShouldClose(window))
     {
+        // Gather this frame's input: from the log when replaying, otherwise from GLFW and the wall clock
+        FrameInput input;
+        if (replayer.isOpen())
+        {
+            if (!replayer.next(input))
+                break;
+
+            // Follow resizes made during the recording
+            resizeWindowToFramebuffer(window, input.framebufferWidth, input.framebufferHeight);
+        }
+        else
+        {
+            float currentFrame = glfwGetTime();
+            input = pollInput(window, currentFrame - lastFrame);
+            lastFrame = currentFrame;
+        }
+
+        if (recorder.isOpen())
+            recorder.record(input);
+
         // Calculate delta time (time between current frame and last frame)
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+        deltaTime = input.deltaTime;
+        elapsedTime += deltaTime;
 
         // Handle user input for zooming
-        processInput(window);
+        processInput(window, input);
 
         // Update camera angles automatically based on elapsed time
         updateCameraAngles();
@@ -588,8 +1334,12 @@ int main()
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // Set clear color to black
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Draw the coordinate axes
-        drawAxes(shaderProgram);
+        // Bin the lights for this frame's camera, then draw the lit ground and the coordinate axes
+        Matrix4 view = cameraViewMatrix();
+        Matrix4 projection = cameraProjectionMatrix();
+        binSceneLights(shaderProgram, view);
+        drawGround(shaderProgram, view, projection);
+        drawAxes(shaderProgram, view, projection);
 
         // Swap the front and back buffers to display the rendered frame
         glfwSwapBuffers(window);
@@ -597,6 +1347,16 @@ int main()
         glfwPollEvents();
     }
 
+    // Report how long the replay took compared to the time it recorded
+    if (replayer.isOpen())
+    {
+        double wallTime = glfwGetTime() - loopStart;
+        std::cout << "Replayed " << replayer.frames() << " frames (" << elapsedTime << " s recorded) in "
+                  << wallTime << " s wall time" << std::endl;
+    }
+    if (recorder.isOpen())
+        std::cout << "Recorded " << recorder.frames() << " frames to " << recordPath << std::endl;
+
     // Clean up resources by deleting the shader program
     glDeleteProgram(shaderProgram);
 
@@ -0,0 +1,159 @@
+#pragma once
+
+// Include standard headers
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+/*
+ * FrameInput:
+ * Everything the application reads from the outside world during one frame.
+ *
+ * The render loop never queries GLFW or the wall clock directly; it consumes one FrameInput per frame.
+ * Live frames are captured from GLFW, recorded frames are read back from a log, so a replay drives the
+ * exact same frame sequence as the original run. This includes the framebuffer size, which sets the
+ * viewport and aspect ratio, so resizing the window during a replay does not change what is rendered.
+ */
+struct FrameInput {
+    // Key bits, one per action the application reacts to
+    enum Key : uint8_t {
+        KeyEscape  = 1 << 0,
+        KeyZoomIn  = 1 << 1,
+        KeyZoomOut = 1 << 2
+    };
+
+    float deltaTime = 0.0f;          // Seconds since the previous frame
+    uint8_t keys = 0;                // Combination of Key bits held down this frame
+    uint16_t framebufferWidth = 0;   // Framebuffer size in pixels this frame
+    uint16_t framebufferHeight = 0;
+
+    bool isDown(Key key) const {
+        return (keys & key) != 0;
+    }
+};
+
+/*
+ * Input log format (little-endian):
+ *
+ * [ magic "TI3I" ][ uint32 version ][ uint32 lightCount ]
+ * [ float deltaTime ][ uint8 keys ][ uint16 framebufferWidth ][ uint16 framebufferHeight ]
+ *                                      repeated once per frame until end of file
+ *
+ * The header also stores the scene settings that change what a frame renders (the point light count), so
+ * a replay rebuilds the recorded scene. Nine bytes per frame keeps an hour of 60 Hz input at roughly 2 MB.
+ */
+const char inputLogMagic[4] = { 'T', 'I', '3', 'I' };
+const uint32_t inputLogVersion = 3;
+
+/*
+ * InputRecorder:
+ * Appends every frame's input to a binary log for later replay.
+ */
+class InputRecorder {
+public:
+    // Open the log file and write its header. Returns false if the file cannot be created.
+    bool open(const std::string& path, uint32_t lightCount) {
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        file.write(inputLogMagic, sizeof(inputLogMagic));
+        file.write(reinterpret_cast<const char*>(&inputLogVersion), sizeof(inputLogVersion));
+        file.write(reinterpret_cast<const char*>(&lightCount), sizeof(lightCount));
+        frameCount = 0;
+        return static_cast<bool>(file);
+    }
+
+    bool isOpen() const {
+        return file.is_open();
+    }
+
+    // Write one frame record
+    void record(const FrameInput& input) {
+        file.write(reinterpret_cast<const char*>(&input.deltaTime), sizeof(input.deltaTime));
+        file.write(reinterpret_cast<const char*>(&input.keys), sizeof(input.keys));
+        file.write(reinterpret_cast<const char*>(&input.framebufferWidth), sizeof(input.framebufferWidth));
+        file.write(reinterpret_cast<const char*>(&input.framebufferHeight), sizeof(input.framebufferHeight));
+        ++frameCount;
+    }
+
+    unsigned long frames() const {
+        return frameCount;
+    }
+
+private:
+    std::ofstream file;
+    unsigned long frameCount = 0;
+};
+
+/*
+ * InputReplayer:
+ * Reads a log written by InputRecorder back one frame at a time.
+ */
+class InputReplayer {
+public:
+    // Open the log file and validate its header. Returns false if the file is missing or not an input log.
+    bool open(const std::string& path) {
+        file.open(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        char magic[4];
+        uint32_t version = 0;
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        file.read(reinterpret_cast<char*>(&recordedLightCount), sizeof(recordedLightCount));
+        frameCount = 0;
+        return file && std::memcmp(magic, inputLogMagic, sizeof(magic)) == 0 && version == inputLogVersion;
+    }
+
+    bool isOpen() const {
+        return file.is_open();
+    }
+
+    // Point light count of the recorded scene
+    uint32_t lightCount() const {
+        return recordedLightCount;
+    }
+
+    // Read the next frame record. Returns false once the log is exhausted.
+    bool next(FrameInput& input) {
+        if (!readFrame(input))
+            return false;
+
+        ++frameCount;
+        return true;
+    }
+
+    // Read the next frame record without consuming it. Returns false once the log is exhausted.
+    bool peek(FrameInput& input) {
+        std::streampos position = file.tellg();
+        bool read = readFrame(input);
+        file.clear();
+        file.seekg(position);
+        return read;
+    }
+
+    unsigned long frames() const {
+        return frameCount;
+    }
+
+private:
+    bool readFrame(FrameInput& input) {
+        FrameInput frame;
+        file.read(reinterpret_cast<char*>(&frame.deltaTime), sizeof(frame.deltaTime));
+        file.read(reinterpret_cast<char*>(&frame.keys), sizeof(frame.keys));
+        file.read(reinterpret_cast<char*>(&frame.framebufferWidth), sizeof(frame.framebufferWidth));
+        file.read(reinterpret_cast<char*>(&frame.framebufferHeight), sizeof(frame.framebufferHeight));
+        if (!file)
+            return false;
+
+        input = frame;
+        return true;
+    }
+
+    std::ifstream file;
+    uint32_t recordedLightCount = 0;
+    unsigned long frameCount = 0;
+};
@@ -0,0 +1,397 @@
+#pragma once
+
+// Include standard headers
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// SSE2 is part of every x64 target; use it for the sphere/cluster tests when available
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TI3D_CLUSTER_SSE2 1
+#endif
+
+/*
+ * ClusterGrid:
+ * Describes the view-space froxel grid used for clustered forward shading.
+ *
+ * Mathematical Concept:
+ * - The screen is divided into tilesX * tilesY tiles, each one a slab of NDC space.
+ * - Depth is divided into slicesZ slices spaced exponentially between the near and far planes:
+ *     depth(k) = zNear * (zFar / zNear)^(k / slicesZ)
+ *   so clusters keep a roughly constant aspect ratio as they get further from the camera.
+ * - A froxel spans NDC x in [-1 + 2i/tilesX, -1 + 2(i+1)/tilesX]; at view depth d this maps to
+ *   view-space x = ndcX * tan(fovX/2) * d (likewise for y). Each froxel is bounded by the AABB
+ *   of its eight corners.
+ */
+struct ClusterGrid {
+    int tilesX = 16, tilesY = 9, slicesZ = 24;
+    float tanHalfFovX = 1.0f, tanHalfFovY = 1.0f;
+    float zNear = 0.1f, zFar = 100.0f;
+
+    // Take the same parameters as Matrix4::perspective so the grid always matches the projection
+    void setPerspective(float fovYDegrees, float aspect, float nearPlane, float farPlane) {
+        tanHalfFovY = tanf(fovYDegrees * 3.14159265f / 360.0f);
+        tanHalfFovX = tanHalfFovY * aspect;
+        zNear = nearPlane;
+        zFar = farPlane;
+    }
+
+    int clusterCount() const {
+        return tilesX * tilesY * slicesZ;
+    }
+
+    // Positive view depth of the near boundary of slice k (k == slicesZ gives the far plane)
+    float sliceDepth(int k) const {
+        return zNear * powf(zFar / zNear, (float)k / (float)slicesZ);
+    }
+};
+
+/*
+ * ClusterLightBinner:
+ * Assigns point lights to the froxels of a ClusterGrid on the CPU.
+ *
+ * Lights are given in view space (camera looking down -Z) as structure-of-arrays so four of them can be
+ * tested against a froxel at once. Depth slices are independent, so they are distributed across a pool of
+ * worker threads that is created on the first multithreaded bin() and woken for each later call.
+ *
+ * Each slice culls the lights hierarchically: first to those touching the slice, then to those touching
+ * each row of tiles, and only the survivors of a row are tested against the tiles of that row.
+ *
+ * The result is a single light-index list plus an (offset, count) pair per cluster, laid out ready to be
+ * uploaded to the GPU in one buffer each.
+ */
+class ClusterLightBinner {
+public:
+    ClusterLightBinner() {
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = cores > 0 ? cores : 1;
+    }
+
+    ~ClusterLightBinner() {
+        stopWorkers();
+    }
+
+    // The worker threads refer back to their binner, so it cannot be copied
+    ClusterLightBinner(const ClusterLightBinner&) = delete;
+    ClusterLightBinner& operator=(const ClusterLightBinner&) = delete;
+
+    // Threads used by bin(), including the calling thread. Changing it restarts the worker pool on the next bin().
+    void setThreadCount(unsigned int count) {
+        stopWorkers();
+        threadCount = count > 0 ? count : 1;
+    }
+
+    unsigned int threads() const {
+        return threadCount;
+    }
+
+    /*
+     * Bin lightCount lights into the clusters of grid.
+     *
+     * Parameters:
+     * - x, y, z: View-space light centers.
+     * - radius: Light influence radii; a light contributes nothing beyond its radius.
+     */
+    void bin(const ClusterGrid& grid, const float* x, const float* y, const float* z, const float* radius, int lightCount) {
+        slices.resize(grid.slicesZ);
+
+        int workerCount = std::min((int)threadCount, grid.slicesZ);
+        if (workerCount <= 1)
+        {
+            for (int k = 0; k < grid.slicesZ; ++k)
+                binSlice(grid, k, x, y, z, radius, lightCount, slices[k]);
+        }
+        else
+        {
+            if (workers.size() != (size_t)workerCount - 1)
+                startWorkers(workerCount - 1);
+
+            // Publish the job and wake the pool; the calling thread works on it too
+            {
+                std::lock_guard<std::mutex> lock(poolMutex);
+                job = Job{ &grid, x, y, z, radius, lightCount };
+                nextSlice = 0;
+                pendingWorkers = workers.size();
+                ++jobGeneration;
+            }
+            wakeWorkers.notify_all();
+            runJob();
+
+            std::unique_lock<std::mutex> lock(poolMutex);
+            workersDone.wait(lock, [this]() { return pendingWorkers == 0; });
+        }
+
+        // Merge the per-slice lists into one index buffer; slices are stored in cluster order already
+        size_t total = 0;
+        for (const SliceBins& s : slices)
+            total += s.indices.size();
+
+        ranges.resize(2 * (size_t)grid.clusterCount());
+        indices.resize(total);
+
+        uint32_t offset = 0;
+        int tilesPerSlice = grid.tilesX * grid.tilesY;
+        for (int k = 0; k < grid.slicesZ; ++k)
+        {
+            const SliceBins& s = slices[k];
+            std::copy(s.indices.begin(), s.indices.end(), indices.begin() + offset);
+            for (int t = 0; t < tilesPerSlice; ++t)
+            {
+                size_t cluster = (size_t)k * tilesPerSlice + t;
+                ranges[2 * cluster + 0] = offset;
+                ranges[2 * cluster + 1] = s.counts[t];
+                offset += s.counts[t];
+            }
+        }
+    }
+
+    // Two entries per cluster: offset into lightIndices() and number of lights
+    const std::vector<uint32_t>& clusterRanges() const {
+        return ranges;
+    }
+
+    // Concatenated light lists of all clusters
+    const std::vector<uint32_t>& lightIndices() const {
+        return indices;
+    }
+
+private:
+    // Arguments of the bin() call the worker pool is currently processing
+    struct Job {
+        const ClusterGrid* grid = nullptr;
+        const float *x = nullptr, *y = nullptr, *z = nullptr, *radius = nullptr;
+        int lightCount = 0;
+    };
+
+    // Bin slices of the current job until none are left. Workers pull slices from a shared counter, so uneven
+    // slices balance out.
+    void runJob() {
+        for (int k = nextSlice++; k < job.grid->slicesZ; k = nextSlice++)
+            binSlice(*job.grid, k, job.x, job.y, job.z, job.radius, job.lightCount, slices[k]);
+    }
+
+    // Worker thread body: sleep until a new job is published, help with it, report back
+    void workerLoop(unsigned long generation) {
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(poolMutex);
+                wakeWorkers.wait(lock, [&]() { return stopping || jobGeneration != generation; });
+                if (stopping)
+                    return;
+                generation = jobGeneration;
+            }
+
+            runJob();
+
+            std::lock_guard<std::mutex> lock(poolMutex);
+            if (--pendingWorkers == 0)
+                workersDone.notify_one();
+        }
+    }
+
+    void startWorkers(int count) {
+        stopWorkers();
+        for (int i = 0; i < count; ++i)
+            workers.emplace_back(&ClusterLightBinner::workerLoop, this, jobGeneration);
+    }
+
+    void stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            stopping = true;
+        }
+        wakeWorkers.notify_all();
+        for (std::thread& t : workers)
+            t.join();
+        workers.clear();
+        stopping = false;
+    }
+
+    // Lights selected by a culling pass, gathered into contiguous arrays padded to a multiple of four
+    struct LightSet {
+        std::vector<uint32_t> lights;
+        std::vector<float> x, y, z, r;
+
+        size_t paddedSize() const {
+            return x.size();
+        }
+    };
+
+    // Scratch and output of one depth slice, reused between calls to avoid reallocations
+    struct SliceBins {
+        LightSet sliceLights, rowLights;
+        std::vector<uint32_t> counts;
+        std::vector<uint32_t> indices;
+    };
+
+    /*
+     * Sphere/AABB overlap for four spheres at once.
+     *
+     * Mathematical Concept:
+     * - The squared distance from a point to a box is the sum over axes of the squared distance to the
+     *   box's extent on that axis (zero when inside). The sphere overlaps the box when that distance is
+     *   no more than radius^2.
+     *
+     * Returns a 4-bit mask with bit i set when sphere i overlaps the box.
+     */
+    static int sphereAabbMask4(const float* x, const float* y, const float* z, const float* r,
+                               const float boxMin[3], const float boxMax[3]) {
+#ifdef TI3D_CLUSTER_SSE2
+        const __m128 zero = _mm_setzero_ps();
+        __m128 px = _mm_loadu_ps(x), py = _mm_loadu_ps(y), pz = _mm_loadu_ps(z), pr = _mm_loadu_ps(r);
+
+        __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(boxMin[0]), px), _mm_sub_ps(px, _mm_set1_ps(boxMax[0]))), zero);
+        __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(boxMin[1]), py), _mm_sub_ps(py, _mm_set1_ps(boxMax[1]))), zero);
+        __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(boxMin[2]), pz), _mm_sub_ps(pz, _mm_set1_ps(boxMax[2]))), zero);
+
+        __m128 dist2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        return _mm_movemask_ps(_mm_cmple_ps(dist2, _mm_mul_ps(pr, pr)));
+#else
+        int mask = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            float dx = std::max(std::max(boxMin[0] - x[i], x[i] - boxMax[0]), 0.0f);
+            float dy = std::max(std::max(boxMin[1] - y[i], y[i] - boxMax[1]), 0.0f);
+            float dz = std::max(std::max(boxMin[2] - z[i], z[i] - boxMax[2]), 0.0f);
+            if (dx * dx + dy * dy + dz * dz <= r[i] * r[i])
+                mask |= 1 << i;
+        }
+        return mask;
+#endif
+    }
+
+    // Append the indices of set bits in mask, offset by base, to out
+    static void appendMask(int mask, uint32_t base, const uint32_t* remap, std::vector<uint32_t>& out) {
+        while (mask)
+        {
+            int bit = 0;
+            while (!(mask & (1 << bit)))
+                ++bit;
+            out.push_back(remap ? remap[base + bit] : base + bit);
+            mask &= mask - 1;
+        }
+    }
+
+    // Froxel AABB in view space for NDC range [ndcMinX, ndcMaxX] x [ndcMinY, ndcMaxY] between two depths
+    static void froxelBounds(const ClusterGrid& grid, float ndcMinX, float ndcMaxX, float ndcMinY, float ndcMaxY,
+                             float depthNear, float depthFar, float boxMin[3], float boxMax[3]) {
+        float sx = grid.tanHalfFovX, sy = grid.tanHalfFovY;
+        boxMin[0] = std::min(ndcMinX * sx * depthNear, ndcMinX * sx * depthFar);
+        boxMax[0] = std::max(ndcMaxX * sx * depthNear, ndcMaxX * sx * depthFar);
+        boxMin[1] = std::min(ndcMinY * sy * depthNear, ndcMinY * sy * depthFar);
+        boxMax[1] = std::max(ndcMaxY * sy * depthNear, ndcMaxY * sy * depthFar);
+        boxMin[2] = -depthFar;
+        boxMax[2] = -depthNear;
+    }
+
+    // Copy the selected lights into set's arrays, padding with spheres that never overlap anything
+    static void gather(const float* x, const float* y, const float* z, const float* radius, LightSet& set) {
+        size_t count = set.lights.size();
+        size_t padded = (count + 3) & ~(size_t)3;
+        set.x.assign(padded, 1e30f);
+        set.y.assign(padded, 1e30f);
+        set.z.assign(padded, 1e30f);
+        set.r.assign(padded, 0.0f);
+        for (size_t c = 0; c < count; ++c)
+        {
+            uint32_t light = set.lights[c];
+            set.x[c] = x[light];
+            set.y[c] = y[light];
+            set.z[c] = z[light];
+            set.r[c] = radius[light];
+        }
+    }
+
+    // Append the lights of set overlapping the box to out
+    static void cull(const LightSet& set, const float boxMin[3], const float boxMax[3], std::vector<uint32_t>& out) {
+        for (size_t c = 0; c < set.paddedSize(); c += 4)
+        {
+            int mask = sphereAabbMask4(&set.x[c], &set.y[c], &set.z[c], &set.r[c], boxMin, boxMax);
+            appendMask(mask, (uint32_t)c, set.lights.data(), out);
+        }
+    }
+
+    void binSlice(const ClusterGrid& grid, int k, const float* x, const float* y, const float* z, const float* radius,
+                  int lightCount, SliceBins& out) const {
+        float depthNear = grid.sliceDepth(k);
+        float depthFar = grid.sliceDepth(k + 1);
+        float boxMin[3], boxMax[3];
+
+        // Keep only the lights touching the whole slice
+        out.sliceLights.lights.clear();
+        froxelBounds(grid, -1.0f, 1.0f, -1.0f, 1.0f, depthNear, depthFar, boxMin, boxMax);
+        int i = 0;
+        for (; i + 4 <= lightCount; i += 4)
+            appendMask(sphereAabbMask4(x + i, y + i, z + i, radius + i, boxMin, boxMax), (uint32_t)i, nullptr, out.sliceLights.lights);
+        if (i < lightCount)
+        {
+            float tx[4], ty[4], tz[4], tr[4];
+            loadTail(x, y, z, radius, i, lightCount, tx, ty, tz, tr);
+            appendMask(sphereAabbMask4(tx, ty, tz, tr, boxMin, boxMax), (uint32_t)i, nullptr, out.sliceLights.lights);
+        }
+        gather(x, y, z, radius, out.sliceLights);
+
+        // Per row of tiles, narrow the slice's lights down to the row, then test them against each tile in cluster order
+        out.counts.assign((size_t)grid.tilesX * grid.tilesY, 0);
+        out.indices.clear();
+        for (int ty = 0; ty < grid.tilesY; ++ty)
+        {
+            float ndcMinY = -1.0f + 2.0f * ty / grid.tilesY;
+            float ndcMaxY = -1.0f + 2.0f * (ty + 1) / grid.tilesY;
+
+            out.rowLights.lights.clear();
+            froxelBounds(grid, -1.0f, 1.0f, ndcMinY, ndcMaxY, depthNear, depthFar, boxMin, boxMax);
+            cull(out.sliceLights, boxMin, boxMax, out.rowLights.lights);
+            if (out.rowLights.lights.empty())
+                continue;
+            gather(x, y, z, radius, out.rowLights);
+
+            for (int tx = 0; tx < grid.tilesX; ++tx)
+            {
+                float ndcMinX = -1.0f + 2.0f * tx / grid.tilesX;
+                float ndcMaxX = -1.0f + 2.0f * (tx + 1) / grid.tilesX;
+                froxelBounds(grid, ndcMinX, ndcMaxX, ndcMinY, ndcMaxY, depthNear, depthFar, boxMin, boxMax);
+
+                size_t before = out.indices.size();
+                cull(out.rowLights, boxMin, boxMax, out.indices);
+                out.counts[(size_t)ty * grid.tilesX + tx] = (uint32_t)(out.indices.size() - before);
+            }
+        }
+    }
+
+    // Copy the last (lightCount - first) < 4 lights into 4-wide arrays padded with non-overlapping spheres
+    static void loadTail(const float* x, const float* y, const float* z, const float* radius, int first, int lightCount,
+                         float tx[4], float ty[4], float tz[4], float tr[4]) {
+        for (int j = 0; j < 4; ++j)
+        {
+            bool valid = first + j < lightCount;
+            tx[j] = valid ? x[first + j] : 1e30f;
+            ty[j] = valid ? y[first + j] : 1e30f;
+            tz[j] = valid ? z[first + j] : 1e30f;
+            tr[j] = valid ? radius[first + j] : 0.0f;
+        }
+    }
+
+    unsigned int threadCount = 1;
+
+    // Persistent worker pool
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable wakeWorkers, workersDone;
+    unsigned long jobGeneration = 0;
+    size_t pendingWorkers = 0;
+    bool stopping = false;
+    Job job;
+    std::atomic<int> nextSlice{ 0 };
+
+    std::vector<SliceBins> slices;
+    std::vector<uint32_t> ranges;
+    std::vector<uint32_t> indices;
+};
@@ -0,0 +1,683 @@
+#pragma once
+
+// Include standard headers
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// SSE2 is part of every x64 target; use it for the attribute encoders and decoders when available
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TI3D_VERTEX_SSE2 1
+#endif
+
+/*
+ * Compressed vertex formats:
+ *
+ * - Positions: 16-bit unsigned normalized per component, relative to the mesh's bounding box.
+ *   p = boundsMin + q / 65535 * (boundsMax - boundsMin). The GPU reads the attribute as normalized
+ *   [0, 1] values and the bounds are folded into the model matrix, so the shader is unchanged.
+ *   Stored as four shorts (the fourth is padding) to keep every attribute 4-byte aligned.
+ * - Normals: octahedral encoding in two 16-bit signed normalized components. The unit sphere is
+ *   projected onto the octahedron |x| + |y| + |z| = 1 and the lower half is folded over the upper half,
+ *   giving a square [-1, 1]^2 parameterization with near-uniform precision.
+ * - UVs: IEEE half floats, rounded to nearest even.
+ *
+ * Only positions are consumed by the GPU so far; packed normals and UVs are encoded and decoded on the CPU.
+ * A GPU consumer of octahedral normals should fetch them as integers and decode max(c / 32767, -1) in the
+ * shader, since GL 3.3 may convert normalized shorts as (2c + 1) / 65535 instead.
+ *
+ * All encoders round to nearest, so the SIMD paths and their scalar tails produce identical bits.
+ */
+
+// Axis-aligned bounding box used to quantize positions
+struct MeshBounds {
+    float min[3] = { 0.0f, 0.0f, 0.0f };
+    float max[3] = { 0.0f, 0.0f, 0.0f };
+
+    // Compute the bounds of count float3 positions
+    static MeshBounds fromPositions(const float* positions, size_t count) {
+        MeshBounds bounds;
+        for (int a = 0; a < 3; ++a)
+        {
+            bounds.min[a] = count > 0 ? positions[a] : 0.0f;
+            bounds.max[a] = bounds.min[a];
+        }
+        for (size_t i = 1; i < count; ++i)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                bounds.min[a] = std::min(bounds.min[a], positions[3 * i + a]);
+                bounds.max[a] = std::max(bounds.max[a], positions[3 * i + a]);
+            }
+        }
+        return bounds;
+    }
+
+    float extent(int axis) const {
+        return max[axis] - min[axis];
+    }
+};
+
+/*
+ * quantizePositions:
+ * Encodes count float3 positions as four unsigned shorts each (x, y, z, padding).
+ */
+inline void quantizePositions(const float* positions, size_t count, const MeshBounds& bounds, uint16_t* out) {
+    float scale[3];
+    for (int a = 0; a < 3; ++a)
+        scale[a] = bounds.extent(a) > 0.0f ? 65535.0f / bounds.extent(a) : 0.0f; // Flat axes quantize to zero
+
+    size_t i = 0;
+#ifdef TI3D_VERTEX_SSE2
+    const __m128 minimum = _mm_set_ps(0.0f, bounds.min[2], bounds.min[1], bounds.min[0]);
+    const __m128 factor = _mm_set_ps(0.0f, scale[2], scale[1], scale[0]);
+    const __m128 upper = _mm_set1_ps(65535.0f);
+    const __m128i bias32 = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+
+    // Two vertices per iteration: eight 32-bit lanes packed into eight shorts
+    for (; i + 2 <= count; i += 2)
+    {
+        const float* p = positions + 3 * i;
+        __m128 a = _mm_set_ps(0.0f, p[2], p[1], p[0]);
+        __m128 b = _mm_set_ps(0.0f, p[5], p[4], p[3]);
+        a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(a, minimum), factor), _mm_setzero_ps()), upper);
+        b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(b, minimum), factor), _mm_setzero_ps()), upper);
+
+        // SSE2 only has a signed 32 -> 16 pack: shift into signed range, pack, then flip the top bit back
+        __m128i qa = _mm_sub_epi32(_mm_cvtps_epi32(a), bias32);
+        __m128i qb = _mm_sub_epi32(_mm_cvtps_epi32(b), bias32);
+        __m128i packed = _mm_xor_si128(_mm_packs_epi32(qa, qb), bias16);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i), packed);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        for (int a = 0; a < 3; ++a)
+        {
+            float q = (positions[3 * i + a] - bounds.min[a]) * scale[a];
+            out[4 * i + a] = (uint16_t)lrintf(std::min(std::max(q, 0.0f), 65535.0f));
+        }
+        out[4 * i + 3] = 0;
+    }
+}
+
+/*
+ * dequantizePositions:
+ * Decodes positions written by quantizePositions back to float3.
+ */
+inline void dequantizePositions(const uint16_t* in, size_t count, const MeshBounds& bounds, float* positions) {
+    float scale[3];
+    for (int a = 0; a < 3; ++a)
+        scale[a] = bounds.extent(a) / 65535.0f;
+
+    size_t i = 0;
+#ifdef TI3D_VERTEX_SSE2
+    const __m128 minimum = _mm_set_ps(0.0f, bounds.min[2], bounds.min[1], bounds.min[0]);
+    const __m128 factor = _mm_set_ps(0.0f, scale[2], scale[1], scale[0]);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4 * i));
+        __m128 a = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, zero));
+        __m128 b = _mm_cvtepi32_ps(_mm_unpackhi_epi16(packed, zero));
+
+        float decoded[8];
+        _mm_storeu_ps(decoded, _mm_add_ps(_mm_mul_ps(a, factor), minimum));
+        _mm_storeu_ps(decoded + 4, _mm_add_ps(_mm_mul_ps(b, factor), minimum));
+        std::memcpy(positions + 3 * i, decoded, 3 * sizeof(float));
+        std::memcpy(positions + 3 * i + 3, decoded + 4, 3 * sizeof(float));
+    }
+#endif
+    for (; i < count; ++i)
+        for (int a = 0; a < 3; ++a)
+            positions[3 * i + a] = in[4 * i + a] * scale[a] + bounds.min[a];
+}
+
+/*
+ * encodeOctahedralNormals:
+ * Encodes count unit float3 normals as two signed shorts each.
+ *
+ * Mathematical Concept:
+ * - Project onto the octahedron: p = n / (|n.x| + |n.y| + |n.z|).
+ * - For the lower hemisphere (n.z < 0) fold: p.xy = (1 - |p.yx|) * sign(p.xy).
+ * - Store p.xy as snorm16: round(p * 32767).
+ */
+inline void encodeOctahedralNormals(const float* normals, size_t count, int16_t* out) {
+    size_t i = 0;
+#ifdef TI3D_VERTEX_SSE2
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 snorm = _mm_set1_ps(32767.0f);
+
+    // Four normals per iteration, transposed to one register per component
+    for (; i + 4 <= count; i += 4)
+    {
+        const float* n = normals + 3 * i;
+        __m128 x = _mm_set_ps(n[9], n[6], n[3], n[0]);
+        __m128 y = _mm_set_ps(n[10], n[7], n[4], n[1]);
+        __m128 z = _mm_set_ps(n[11], n[8], n[5], n[2]);
+
+        __m128 absSum = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signBit, x), _mm_andnot_ps(signBit, y)), _mm_andnot_ps(signBit, z));
+        absSum = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(absSum, _mm_setzero_ps()), absSum),
+                           _mm_andnot_ps(_mm_cmpgt_ps(absSum, _mm_setzero_ps()), one)); // Zero-length normals map to (0, 0)
+        __m128 px = _mm_div_ps(x, absSum);
+        __m128 py = _mm_div_ps(y, absSum);
+
+        // Fold the lower hemisphere; sign() is +1 for zero, as in the scalar path
+        __m128 signX = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(px, _mm_setzero_ps()), signBit), one);
+        __m128 signY = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(py, _mm_setzero_ps()), signBit), one);
+        __m128 foldX = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signBit, py)), signX);
+        __m128 foldY = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signBit, px)), signY);
+        __m128 lower = _mm_cmplt_ps(z, _mm_setzero_ps());
+        px = _mm_or_ps(_mm_and_ps(lower, foldX), _mm_andnot_ps(lower, px));
+        py = _mm_or_ps(_mm_and_ps(lower, foldY), _mm_andnot_ps(lower, py));
+
+        __m128i qx = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(px, _mm_set1_ps(-1.0f)), one), snorm));
+        __m128i qy = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(py, _mm_set1_ps(-1.0f)), one), snorm));
+
+        // Interleave back to (x, y) pairs
+        __m128i packed = _mm_packs_epi32(_mm_unpacklo_epi32(qx, qy), _mm_unpackhi_epi32(qx, qy));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), packed);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float x = normals[3 * i], y = normals[3 * i + 1], z = normals[3 * i + 2];
+        float absSum = fabsf(x) + fabsf(y) + fabsf(z);
+        if (!(absSum > 0.0f))
+            absSum = 1.0f;
+        float px = x / absSum, py = y / absSum;
+        if (z < 0.0f)
+        {
+            float foldX = (1.0f - fabsf(py)) * (px < 0.0f ? -1.0f : 1.0f);
+            float foldY = (1.0f - fabsf(px)) * (py < 0.0f ? -1.0f : 1.0f);
+            px = foldX;
+            py = foldY;
+        }
+        out[2 * i] = (int16_t)lrintf(std::min(std::max(px, -1.0f), 1.0f) * 32767.0f);
+        out[2 * i + 1] = (int16_t)lrintf(std::min(std::max(py, -1.0f), 1.0f) * 32767.0f);
+    }
+}
+
+/*
+ * decodeOctahedralNormals:
+ * Decodes normals written by encodeOctahedralNormals back to unit float3.
+ *
+ * Mathematical Concept:
+ * - z = 1 - |x| - |y|; where z < 0 the point was folded, so move x and y back towards the axes by -z.
+ */
+inline void decodeOctahedralNormals(const int16_t* in, size_t count, float* normals) {
+    size_t i = 0;
+#ifdef TI3D_VERTEX_SSE2
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 invSnorm = _mm_set1_ps(1.0f / 32767.0f);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        // Sign-extend the eight shorts to 32 bits and split into x and y registers
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16));
+        __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16));
+        __m128 x = _mm_max_ps(_mm_mul_ps(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)), invSnorm), _mm_set1_ps(-1.0f));
+        __m128 y = _mm_max_ps(_mm_mul_ps(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)), invSnorm), _mm_set1_ps(-1.0f));
+
+        __m128 z = _mm_sub_ps(_mm_sub_ps(one, _mm_andnot_ps(signBit, x)), _mm_andnot_ps(signBit, y));
+        __m128 t = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), z), _mm_setzero_ps());
+        x = _mm_add_ps(x, _mm_xor_ps(t, _mm_andnot_ps(_mm_cmplt_ps(x, _mm_setzero_ps()), signBit)));
+        y = _mm_add_ps(y, _mm_xor_ps(t, _mm_andnot_ps(_mm_cmplt_ps(y, _mm_setzero_ps()), signBit)));
+
+        __m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(length2));
+
+        float xs[4], ys[4], zs[4];
+        _mm_storeu_ps(xs, _mm_mul_ps(x, invLength));
+        _mm_storeu_ps(ys, _mm_mul_ps(y, invLength));
+        _mm_storeu_ps(zs, _mm_mul_ps(z, invLength));
+        for (int j = 0; j < 4; ++j)
+        {
+            normals[3 * (i + j)] = xs[j];
+            normals[3 * (i + j) + 1] = ys[j];
+            normals[3 * (i + j) + 2] = zs[j];
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float x = std::max(in[2 * i] * (1.0f / 32767.0f), -1.0f);
+        float y = std::max(in[2 * i + 1] * (1.0f / 32767.0f), -1.0f);
+        float z = 1.0f - fabsf(x) - fabsf(y);
+        float t = std::max(-z, 0.0f);
+        x += x >= 0.0f ? -t : t;
+        y += y >= 0.0f ? -t : t;
+        float invLength = 1.0f / sqrtf(x * x + y * y + z * z);
+        normals[3 * i] = x * invLength;
+        normals[3 * i + 1] = y * invLength;
+        normals[3 * i + 2] = z * invLength;
+    }
+}
+
+/*
+ * floatToHalf:
+ * Converts one float to an IEEE half float with round-to-nearest-even.
+ * Overflow becomes infinity, NaN stays NaN and values below the half normal range become subnormals.
+ */
+inline uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint32_t half;
+    if (bits >= (127u + 16u) << 23) // Too large for a half: infinity or NaN
+    {
+        half = bits > 255u << 23 ? 0x7e00u : 0x7c00u;
+    }
+    else if (bits < 113u << 23) // Half subnormal or zero
+    {
+        // Adding a magic value lines the 10 mantissa bits up at the bottom; FP addition does the rounding
+        const uint32_t magicBits = (127u - 15u + 23u - 10u + 1u) << 23;
+        float magic, shifted;
+        std::memcpy(&magic, &magicBits, sizeof(magic));
+        std::memcpy(&shifted, &bits, sizeof(shifted));
+        shifted += magic;
+        std::memcpy(&half, &shifted, sizeof(half));
+        half -= magicBits;
+    }
+    else
+    {
+        // Rebias the exponent and round the 13 dropped mantissa bits to nearest even
+        uint32_t mantissaOdd = (bits >> 13) & 1u;
+        bits += ((uint32_t)(15 - 127) << 23) + 0xfffu + mantissaOdd;
+        half = bits >> 13;
+    }
+    return (uint16_t)(half | (sign >> 16));
+}
+
+/*
+ * halfToFloat:
+ * Converts one IEEE half float to a float (exact).
+ */
+inline float halfToFloat(uint16_t half) {
+    const uint32_t shiftedExponent = 0x7c00u << 13;
+    uint32_t bits = ((uint32_t)half & 0x7fffu) << 13;
+    uint32_t exponent = bits & shiftedExponent;
+    bits += (127u - 15u) << 23;
+
+    float value;
+    if (exponent == shiftedExponent) // Infinity or NaN
+    {
+        bits += (128u - 16u) << 23;
+        std::memcpy(&value, &bits, sizeof(value));
+    }
+    else if (exponent == 0) // Zero or subnormal: renormalize through the FPU
+    {
+        bits += 1u << 23;
+        std::memcpy(&value, &bits, sizeof(value));
+        value -= 6.10351562e-05f; // 2^-14, the smallest half normal
+    }
+    else
+    {
+        std::memcpy(&value, &bits, sizeof(value));
+    }
+
+    uint32_t signBits;
+    std::memcpy(&signBits, &value, sizeof(signBits));
+    signBits |= ((uint32_t)half & 0x8000u) << 16;
+    std::memcpy(&value, &signBits, sizeof(value));
+    return value;
+}
+
+/*
+ * halfRoundingError:
+ * Largest error of floatToHalf over [-magnitude, magnitude]: half an ulp of the largest half below magnitude
+ * (2^-12 for [0, 1]; magnitude itself is exact when it is a power of two). Infinite past the half range.
+ */
+inline float halfRoundingError(float magnitude) {
+    if (!(magnitude > 0.0f))
+        return 0.0f;
+    if (magnitude >= 65520.0f) // Rounds to infinity
+        return INFINITY;
+
+    int exponent;
+    frexpf(nextafterf(magnitude, 0.0f), &exponent);
+    return ldexpf(1.0f, std::max(exponent - 12, -25)); // Subnormal halfs share the fixed ulp 2^-24
+}
+
+/*
+ * encodeHalfFloats:
+ * Converts count floats to half floats, eight at a time with SSE2. Matches floatToHalf bit for bit.
+ */
+inline void encodeHalfFloats(const float* in, size_t count, uint16_t* out) {
+    size_t i = 0;
+#ifdef TI3D_VERTEX_SSE2
+    const __m128i absMask = _mm_set1_epi32(0x7fffffff);
+    const __m128i halfOverflow = _mm_set1_epi32((127 + 16) << 23);
+    const __m128i floatInfinity = _mm_set1_epi32(255 << 23);
+    const __m128i halfNormalMin = _mm_set1_epi32(113 << 23);
+    const __m128i magicBits = _mm_set1_epi32((127 - 15 + 23 - 10 + 1) << 23);
+    const __m128i rebias = _mm_set1_epi32((int)(((uint32_t)(15 - 127) << 23) + 0xfffu));
+    const __m128i bias32 = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+
+    auto convert4 = [&](__m128 value) -> __m128i {
+        __m128i bits = _mm_castps_si128(value);
+        __m128i magnitude = _mm_and_si128(bits, absMask);
+        __m128i sign = _mm_srli_epi32(_mm_andnot_si128(absMask, bits), 16);
+
+        // Magnitudes are below 2^31, so the signed SSE2 integer compares are safe
+        __m128i special = _mm_or_si128(_mm_set1_epi32(0x7c00),
+                                       _mm_and_si128(_mm_cmpgt_epi32(magnitude, floatInfinity), _mm_set1_epi32(0x0200)));
+        __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(magnitude), _mm_castsi128_ps(magicBits))), magicBits);
+        __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(magnitude, 13), _mm_set1_epi32(1));
+        __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(magnitude, rebias), mantissaOdd), 13);
+
+        __m128i isFinite = _mm_cmplt_epi32(magnitude, halfOverflow);
+        __m128i isSubnormal = _mm_cmplt_epi32(magnitude, halfNormalMin);
+        __m128i result = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+        result = _mm_or_si128(_mm_and_si128(isFinite, result), _mm_andnot_si128(isFinite, special));
+        return _mm_sub_epi32(_mm_or_si128(result, sign), bias32);
+    };
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i lo = convert4(_mm_loadu_ps(in + i));
+        __m128i hi = convert4(_mm_loadu_ps(in + i + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(_mm_packs_epi32(lo, hi), bias16));
+    }
+#endif
+    for (; i < count; ++i)
+        out[i] = floatToHalf(in[i]);
+}
+
+/*
+ * decodeHalfFloats:
+ * Converts count half floats to floats, eight at a time with SSE2. Matches halfToFloat bit for bit.
+ */
+inline void decodeHalfFloats(const uint16_t* in, size_t count, float* out) {
+    size_t i = 0;
+#ifdef TI3D_VERTEX_SSE2
+    const __m128i shiftedExponent = _mm_set1_epi32(0x7c00 << 13);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 smallestNormal = _mm_set1_ps(6.10351562e-05f);
+
+    auto convert4 = [&](__m128i half) -> __m128 {
+        __m128i bits = _mm_slli_epi32(_mm_and_si128(half, _mm_set1_epi32(0x7fff)), 13);
+        __m128i exponent = _mm_and_si128(bits, shiftedExponent);
+        bits = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+
+        __m128i isSpecial = _mm_cmpeq_epi32(exponent, shiftedExponent);
+        __m128i isSubnormal = _mm_cmpeq_epi32(exponent, zero);
+        __m128i special = _mm_add_epi32(bits, _mm_set1_epi32((128 - 16) << 23));
+        __m128i subnormal = _mm_castps_si128(_mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))), smallestNormal));
+
+        __m128i result = _mm_or_si128(_mm_and_si128(isSpecial, special), _mm_andnot_si128(isSpecial, bits));
+        result = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, result));
+        result = _mm_or_si128(result, _mm_slli_epi32(_mm_and_si128(half, _mm_set1_epi32(0x8000)), 16));
+        return _mm_castsi128_ps(result);
+    };
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_ps(out + i, convert4(_mm_unpacklo_epi16(packed, zero)));
+        _mm_storeu_ps(out + i + 4, convert4(_mm_unpackhi_epi16(packed, zero)));
+    }
+#endif
+    for (; i < count; ++i)
+        out[i] = halfToFloat(in[i]);
+}
+
+/*
+ * VertexLayout:
+ * Chooses the storage format of each attribute and whether attributes are interleaved in one stream
+ * or stored as separate streams (structure-of-arrays) one after another in the same buffer.
+ */
+struct VertexLayout {
+    enum PositionFormat { PositionFloat3, PositionUnorm16 };
+    enum NormalFormat { NormalNone, NormalFloat3, NormalOctahedral16 };
+    enum UvFormat { UvNone, UvFloat2, UvHalf2 };
+    enum StreamMode { Interleaved, SeparateStreams };
+
+    PositionFormat position = PositionFloat3;
+    NormalFormat normal = NormalNone;
+    UvFormat uv = UvNone;
+    StreamMode streams = Interleaved;
+
+    size_t positionSize() const {
+        return position == PositionUnorm16 ? 4 * sizeof(uint16_t) : 3 * sizeof(float);
+    }
+
+    size_t normalSize() const {
+        return normal == NormalOctahedral16 ? 2 * sizeof(int16_t) : normal == NormalFloat3 ? 3 * sizeof(float) : 0;
+    }
+
+    size_t uvSize() const {
+        return uv == UvHalf2 ? 2 * sizeof(uint16_t) : uv == UvFloat2 ? 2 * sizeof(float) : 0;
+    }
+
+    size_t vertexSize() const {
+        return positionSize() + normalSize() + uvSize();
+    }
+};
+
+// Location of one attribute inside PackedMesh::data, in the form glVertexAttribPointer expects
+struct VertexAttributeStream {
+    size_t offset = 0; // Byte offset of the first vertex's attribute
+    size_t stride = 0; // Bytes between consecutive vertices; 0 when the attribute is absent
+};
+
+/*
+ * PackedMesh:
+ * Vertex data encoded according to a VertexLayout, ready to be uploaded as a single vertex buffer.
+ */
+struct PackedMesh {
+    VertexLayout layout;
+    MeshBounds bounds;
+    size_t vertexCount = 0;
+    VertexAttributeStream position, normal, uv;
+    std::vector<uint8_t> data;
+};
+
+/*
+ * packMesh:
+ * Encodes float vertex attributes into layout. Each attribute is first encoded into its own tight
+ * array by the SIMD encoders, then either copied into place (separate streams) or interleaved.
+ *
+ * Parameters:
+ * - positions: count float3 positions.
+ * - normals: count unit float3 normals, or nullptr when the layout has no normals.
+ * - uvs: count float2 texture coordinates, or nullptr when the layout has no UVs.
+ */
+inline PackedMesh packMesh(const VertexLayout& layout, const float* positions, const float* normals, const float* uvs, size_t count) {
+    PackedMesh mesh;
+    mesh.layout = layout;
+    mesh.vertexCount = count;
+    mesh.bounds = MeshBounds::fromPositions(positions, count);
+
+    // Encode every attribute into a tight stream
+    std::vector<uint8_t> streams[3];
+    streams[0].resize(layout.positionSize() * count);
+    if (layout.position == VertexLayout::PositionUnorm16)
+        quantizePositions(positions, count, mesh.bounds, reinterpret_cast<uint16_t*>(streams[0].data()));
+    else if (count > 0)
+        std::memcpy(streams[0].data(), positions, streams[0].size());
+
+    streams[1].resize(layout.normalSize() * count);
+    if (layout.normal == VertexLayout::NormalOctahedral16)
+        encodeOctahedralNormals(normals, count, reinterpret_cast<int16_t*>(streams[1].data()));
+    else if (layout.normal == VertexLayout::NormalFloat3 && count > 0)
+        std::memcpy(streams[1].data(), normals, streams[1].size());
+
+    streams[2].resize(layout.uvSize() * count);
+    if (layout.uv == VertexLayout::UvHalf2)
+        encodeHalfFloats(uvs, 2 * count, reinterpret_cast<uint16_t*>(streams[2].data()));
+    else if (layout.uv == VertexLayout::UvFloat2 && count > 0)
+        std::memcpy(streams[2].data(), uvs, streams[2].size());
+
+    // Lay the streams out in the final buffer
+    const size_t sizes[3] = { layout.positionSize(), layout.normalSize(), layout.uvSize() };
+    VertexAttributeStream* attributes[3] = { &mesh.position, &mesh.normal, &mesh.uv };
+    mesh.data.resize(layout.vertexSize() * count);
+
+    size_t offset = 0;
+    for (int a = 0; a < 3; ++a)
+    {
+        if (sizes[a] == 0)
+            continue;
+
+        if (layout.streams == VertexLayout::SeparateStreams)
+        {
+            attributes[a]->offset = offset;
+            attributes[a]->stride = sizes[a];
+            std::copy(streams[a].begin(), streams[a].end(), mesh.data.begin() + offset);
+            offset += streams[a].size();
+        }
+        else
+        {
+            attributes[a]->offset = offset;
+            attributes[a]->stride = layout.vertexSize();
+            for (size_t v = 0; v < count; ++v)
+                std::memcpy(&mesh.data[v * layout.vertexSize() + offset], &streams[a][v * sizes[a]], sizes[a]);
+            offset += sizes[a];
+        }
+    }
+
+    return mesh;
+}
+
+/*
+ * unpackMesh:
+ * Decodes a PackedMesh back to float attributes. Vectors for attributes the layout lacks are left empty.
+ */
+inline void unpackMesh(const PackedMesh& mesh, std::vector<float>& positions, std::vector<float>& normals, std::vector<float>& uvs) {
+    const VertexLayout& layout = mesh.layout;
+    size_t count = mesh.vertexCount;
+
+    // Gather one attribute into a tight stream, undoing any interleaving
+    auto gather = [&](const VertexAttributeStream& attribute, size_t size) {
+        std::vector<uint8_t> stream(size * count);
+        for (size_t v = 0; v < count; ++v)
+            std::memcpy(&stream[v * size], &mesh.data[attribute.offset + v * attribute.stride], size);
+        return stream;
+    };
+
+    std::vector<uint8_t> stream = gather(mesh.position, layout.positionSize());
+    positions.resize(3 * count);
+    if (layout.position == VertexLayout::PositionUnorm16)
+        dequantizePositions(reinterpret_cast<const uint16_t*>(stream.data()), count, mesh.bounds, positions.data());
+    else if (count > 0)
+        std::memcpy(positions.data(), stream.data(), stream.size());
+
+    normals.clear();
+    if (layout.normal != VertexLayout::NormalNone)
+    {
+        stream = gather(mesh.normal, layout.normalSize());
+        normals.resize(3 * count);
+        if (layout.normal == VertexLayout::NormalOctahedral16)
+            decodeOctahedralNormals(reinterpret_cast<const int16_t*>(stream.data()), count, normals.data());
+        else if (count > 0)
+            std::memcpy(normals.data(), stream.data(), stream.size());
+    }
+
+    uvs.clear();
+    if (layout.uv != VertexLayout::UvNone)
+    {
+        stream = gather(mesh.uv, layout.uvSize());
+        uvs.resize(2 * count);
+        if (layout.uv == VertexLayout::UvHalf2)
+            decodeHalfFloats(reinterpret_cast<const uint16_t*>(stream.data()), 2 * count, uvs.data());
+        else if (count > 0)
+            std::memcpy(uvs.data(), stream.data(), stream.size());
+    }
+}
+
+/*
+ * VertexCompressionReport:
+ * Memory use and measured error of a PackedMesh against the float data it was packed from.
+ */
+struct VertexCompressionReport {
+    size_t rawBytes = 0;             // Size of the same attributes as 32-bit floats
+    size_t packedBytes = 0;          // Size of PackedMesh::data
+    float maxPositionError = 0.0f;   // Largest per-component position error, in mesh units
+    float positionErrorBound = 0.0f; // Half a quantization step along the longest axis, plus float rounding
+    float maxNormalErrorDegrees = 0.0f;
+    float normalErrorBoundDegrees = 0.0f; // Angle of the largest octahedral snorm16 rounding step, plus float rounding
+    float maxUvError = 0.0f;
+    float uvErrorBound = 0.0f;            // Half a half-float ulp at the largest UV magnitude
+
+    float reduction() const {
+        return rawBytes > 0 ? 1.0f - (float)packedBytes / (float)rawBytes : 0.0f;
+    }
+};
+
+/*
+ * measureCompression:
+ * Decodes mesh and compares it with the original attributes (same arguments as passed to packMesh).
+ */
+inline VertexCompressionReport measureCompression(const PackedMesh& mesh, const float* positions, const float* normals, const float* uvs) {
+    VertexCompressionReport report;
+    size_t count = mesh.vertexCount;
+    report.packedBytes = mesh.data.size();
+    size_t rawFloats = 3;
+    if (mesh.layout.normal != VertexLayout::NormalNone)
+        rawFloats += 3;
+    if (mesh.layout.uv != VertexLayout::UvNone)
+        rawFloats += 2;
+    report.rawBytes = count * rawFloats * sizeof(float);
+
+    if (mesh.layout.position == VertexLayout::PositionUnorm16)
+    {
+        float longest = 0.0f, magnitude = 0.0f;
+        for (int a = 0; a < 3; ++a)
+        {
+            longest = std::max(longest, mesh.bounds.extent(a));
+            magnitude = std::max(magnitude, std::max(fabsf(mesh.bounds.min[a]), fabsf(mesh.bounds.max[a])));
+        }
+        report.positionErrorBound = 0.5f * longest / 65535.0f + 2.0f * magnitude * FLT_EPSILON;
+    }
+
+    if (mesh.layout.normal == VertexLayout::NormalOctahedral16)
+    {
+        // Rounding moves each octahedral coordinate by at most e = 0.5 / 32767, so the decoded point on
+        // |x| + |y| + |z| = 1 moves by at most sqrt(6) e. That point is at least 1 / sqrt(3) from the origin,
+        // which bounds the angle by 3 sqrt(2) e radians (reached near the octahedron's face centers).
+        float step = 3.0f * sqrtf(2.0f) * 0.5f / 32767.0f;
+        report.normalErrorBoundDegrees = (step + 4.0f * FLT_EPSILON) * 180.0f / 3.14159265f;
+    }
+
+    if (mesh.layout.uv == VertexLayout::UvHalf2)
+    {
+        float magnitude = 0.0f;
+        for (size_t i = 0; i < 2 * count; ++i)
+            magnitude = std::max(magnitude, fabsf(uvs[i]));
+        report.uvErrorBound = halfRoundingError(magnitude);
+    }
+
+    std::vector<float> decodedPositions, decodedNormals, decodedUvs;
+    unpackMesh(mesh, decodedPositions, decodedNormals, decodedUvs);
+
+    for (size_t i = 0; i < 3 * count; ++i)
+        report.maxPositionError = std::max(report.maxPositionError, fabsf(decodedPositions[i] - positions[i]));
+
+    for (size_t v = 0; v < count && !decodedNormals.empty(); ++v)
+    {
+        const float* a = &normals[3 * v];
+        const float* b = &decodedNormals[3 * v];
+        // atan2(|a x b|, a . b) stays accurate for tiny angles, where acos(a . b) does not
+        float cx = a[1] * b[2] - a[2] * b[1], cy = a[2] * b[0] - a[0] * b[2], cz = a[0] * b[1] - a[1] * b[0];
+        float angle = atan2f(sqrtf(cx * cx + cy * cy + cz * cz), a[0] * b[0] + a[1] * b[1] + a[2] * b[2]);
+        report.maxNormalErrorDegrees = std::max(report.maxNormalErrorDegrees, angle * 180.0f / 3.14159265f);
+    }
+
+    for (size_t i = 0; i < decodedUvs.size(); ++i)
+        report.maxUvError = std::max(report.maxUvError, fabsf(decodedUvs[i] - uvs[i]));
+
+    return report;
+}